@@ -0,0 +1,98 @@
+#ifndef CKPT_H
+#define CKPT_H
+#include <stddef.h>
+#include <stdint.h>
+#include "product.h"
+#include "tsc.h"
+
+/*
+ * Checkpoints consistentes de la línea (estilo Chandy–Lamport sobre pipes FIFO):
+ *  - La cabeza viva de la línea (E1; o E2/E3 cuando lo de arriba terminó bien,
+ *    es decir, mandó FIN antes del EOF; un EOF sin FIN es una caída)
+ *    inicia cada interval_ms: toma su snapshot y manda un MARCADOR por el pipe.
+ *  - E2/E3: el lector encola el marcador y se detiene; cuando el worker lo saca
+ *    (entre slices, sin producto en servicio) guarda su snapshot, reenvía el
+ *    marcador y libera al lector. Lo que estaba en los pipes antes del marcador
+ *    queda en el snapshot de abajo; lo de después, en el de arriba.
+ *  - E3 confirma "seq cabeza" en "<dir>/committed". --resume usa ese seq; las
+ *    estaciones antes de la cabeza ya habían terminado: recargan solo su
+ *    snapshot final (Gantt y estadísticas, cola vacía).
+ * Los productos parcialmente servidos (RR) viajan en la cola con su rem_ms.
+ */
+
+#define CKPT_MAGIC   0x54504b43u  // "CKPT"
+#define CKPT_VERSION 2
+#define CKPT_SEQ_FINAL 0xffffffffu // estado al terminar bien (ver ckpt_clear)
+
+typedef struct {
+    int  interval_ms;    // 0 = sin checkpoints
+    int  resume;         // 1 = reconstruir desde el último snapshot confirmado
+    char dir[64];        // carpeta de snapshots
+    // completado por ckpt_prepare_resume() en el padre (heredado por fork)
+    uint32_t seq;        // seq confirmado desde el que se reanuda
+    int      head;       // estación que inició ese checkpoint
+    tick_t   epoch_tk;   // epoch rebasado, común a todas las estaciones
+    int32_t  next_id;    // primer id que debe volver a emitir el generador
+} CkptConfig;
+
+typedef struct {
+    uint32_t magic, version;
+    uint32_t station;    // 0..2
+    uint32_t seq;
+    uint32_t nq;         // productos en cola (Product[nq])
+    uint32_t nslices;    // slices de Gantt
+    uint32_t nrecs;      // E3: productos terminados
+    int32_t  next_id;    // cabeza: siguiente id que aún no llegó del generador
+    double   hz;         // ticks/s del proceso que escribió
+    tick_t   epoch_tk;   // epoch vigente (0 = aún no fijado)
+    tick_t   taken_tk;   // instante del snapshot
+    double   sum_tat, sum_wait;
+    int32_t  n_done, st_done;
+    // estadísticas de la estación (model.h), seg. relativos a epoch
+    double   st_area_s, st_busy_s, st_first_s, st_end_s;
+} CkptHeader;
+
+typedef struct {
+    const void *ptr;
+    size_t len;
+} CkptSection;
+
+/* Marcador: Product con id = -seq y svc_ms[0] = estación que lo inició */
+static inline void ckpt_marker(Product *p, uint32_t seq, int head)
+{
+    *p = (Product){0};
+    p->id = -(int32_t)seq;
+    p->svc_ms[0] = head;
+}
+static inline int ckpt_is_marker(const Product *p) { return p->id < 0; }
+/* FIN de flujo: Product con id = 0, se envía justo antes de cerrar el pipe */
+static inline void ckpt_eos(Product *p)
+{
+    *p = (Product){0};
+}
+static inline int ckpt_is_eos(const Product *p) { return p->id == 0; }
+static inline uint32_t ckpt_marker_seq(const Product *p) { return (uint32_t)(-p->id); }
+static inline int ckpt_marker_head(const Product *p) { return p->svc_ms[0]; }
+
+/* duración en ticks del snapshot -> ticks de este proceso */
+static inline int64_t ckpt_rescale(const CkptHeader *h, int64_t dt)
+{
+    return s_to_tk((double)dt / h->hz);
+}
+/* tick absoluto del snapshot -> tick absoluto sobre el epoch rebasado */
+static inline tick_t ckpt_rebase(const CkptConfig *ck, const CkptHeader *h, tick_t t)
+{
+    return t ? ck->epoch_tk + (tick_t)ckpt_rescale(h, (int64_t)(t - h->epoch_tk)) : 0;
+}
+
+int   ckpt_init_dir(const CkptConfig *ck);
+int   ckpt_save(const CkptConfig *ck, const CkptHeader *h,
+                const CkptSection *secs, int nsecs, size_t *bytes);
+void *ckpt_load(const CkptConfig *ck, int station, uint32_t seq, CkptHeader *h, size_t *len);
+int   ckpt_commit(const CkptConfig *ck, uint32_t seq, int head);
+int   ckpt_committed(const CkptConfig *ck, uint32_t *seq, int *head);
+void  ckpt_prune(const CkptConfig *ck, int station, uint32_t below_seq);
+int   ckpt_prepare_resume(CkptConfig *ck);   // padre, antes de fork()
+void  ckpt_clear(const CkptConfig *ck);      // padre: corrida nueva o completa (también .stats)
+
+#endif /* CKPT_H */
@@ -6,6 +6,7 @@
 #include <time.h>
 #include <unistd.h>
 #include <stdlib.h>
+#include "tsc.h"
 
 static inline double now_s(void){
     struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
@@ -36,7 +37,7 @@ static inline int read_full(int fd, void* buf, size_t n){
 
 #define LOG(role, fmt, ...) \
     do { \
-        printf("[%.3f][pid=%d][%s] " fmt "\n", now_s(), (int)getpid(), role, ##__VA_ARGS__); \
+        printf("[%.3f][pid=%d][%s] " fmt "\n", tk_mono_s(tk_now()), (int)getpid(), role, ##__VA_ARGS__); \
     } while(0)
 
 #endif /* IPC_H */
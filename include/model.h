@@ -0,0 +1,46 @@
+#ifndef MODEL_H
+#define MODEL_H
+#include "policy.h"
+#include "product.h"
+
+/*
+ * Contraste con teoría de colas para la línea en tándem E1→E2→E3.
+ *  - Medido por estación (proceso propio): ∫N(t)dt, tiempo ocupado y
+ *    ventana; se deja en /tmp/assembly_stationX.stats como los .ids.
+ *  - Medido por producto (registros de E3): llegada a cada cola (t_arr),
+ *    salida (t_out) y latencia pipe/gate entre estaciones.
+ *  - Predicho: ρ = λ·S, M/M/1, M/G/1 (Pollaczek–Khinchine), G/G/1 (Kingman)
+ *    para FCFS y M/G/1-PS para RR; planificador de workers con M/M/c.
+ */
+
+typedef struct {
+    double target_tput;   // productos/s objetivo para el planificador
+    double rho_max;       // utilización máxima aceptada por worker
+    StationConfig cfg[NSTAGES]; // config de cada estación (si falta su .stats)
+} ModelConfig;
+
+typedef struct {
+    int32_t idx;
+    StationConfig cfg;
+    int32_t n_done;       // productos que salieron de la estación
+    double  span_s;       // ventana: primera llegada → última salida
+    double  area_s;       // ∫ N(t) dt (cola + servicio)
+    double  busy_s;       // tiempo en slices
+} StationStats;
+
+/* Un producto terminado, en segundos relativos a epoch (ya convertido) */
+typedef struct {
+    int    id;
+    double arrival;                 // llegada simulada (arrival_s)
+    double t_arr[NSTAGES];          // llegada a la cola de la estación i
+    double t_in[NSTAGES], t_out[NSTAGES];
+    double svc_s[NSTAGES];
+} ModelRec;
+
+int  stats_save(const StationStats *st);
+int  stats_load(int idx, StationStats *st);
+void stats_clear(void);   // corrida nueva: que E3 no lea stats de otra corrida
+void model_report(const ModelRec *recs, int n,
+                  const StationStats st[NSTAGES], const ModelConfig *mc);
+
+#endif /* MODEL_H */
@@ -4,8 +4,9 @@
 
 /*
  * Un "job" es una unidad de trabajo que pasa por etapas; aquí es un producto.
- * Regla de tiempo: epoch_s es el "cero global", fijado cuando el Producto 1
- * (arrival=0) ENTRA en la Estación 1. Todos los t_in/t_out van relativos a eso.
+ * Regla de tiempo: epoch_tk es el "cero global", fijado cuando el Producto 1
+ * (arrival=0) ENTRA en la Estación 1. Los tiempos se guardan como ticks
+ * absolutos (ver tsc.h); al reportar se restan de epoch_tk y se pasan a seg.
  *
  * Para soportar FCFS y RR, cada producto lleva:
  *  - svc_ms[i]: tiempo de servicio requerido en la estación i (ms).
@@ -17,11 +18,12 @@
 typedef struct {
     int32_t id;                 // 1..N
     double  arrival_s;          // llegada declarada al generar (0..N-1)
-    double  epoch_s;            // cero global (se fija en E1 con el primer ingreso)
+    uint64_t epoch_tk;          // cero global en ticks (se fija en E1 con el primer ingreso)
 
-    // métricas relativas a epoch_s
-    double  t_in_s[NSTAGES];    // entrada a estación i
-    double  t_out_s[NSTAGES];   // salida de estación i
+    // métricas en ticks absolutos (0 = aún no marcado)
+    uint64_t t_arr_tk[NSTAGES]; // llegada a la cola de estación i (E1: al pasar el gate)
+    uint64_t t_in_tk[NSTAGES];  // entrada a estación i
+    uint64_t t_out_tk[NSTAGES]; // salida de estación i
 
     // servicio/reste (ms) por estación
     int32_t svc_ms[NSTAGES];    // tiempo de servicio requerido
@@ -17,6 +17,7 @@ typedef struct {
 int  q_init(ProductQueue* q);
 void q_destroy(ProductQueue* q);
 void q_push(ProductQueue* q, const Product* p); // bloquea si llena
-void q_pop(ProductQueue* q, Product* out);      // bloquea si vacía
+int  q_pop(ProductQueue* q, Product* out);      // bloquea si vacía; 0 = despertado vacío
+int  q_snapshot(ProductQueue* q, Product* out, int max); // copia en orden, sin sacar
 
 #endif /* QUEUE_H */
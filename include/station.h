@@ -2,17 +2,23 @@
 #define STATION_H
 #include "product.h"
 #include "policy.h"
+#include "ckpt.h"
+#include "model.h"
 
-/* Generador: crea N productos (arrival 0..N-1) con svc_ms predefinidos. */
-void generator_process(int out_fd, int count,
+/* Generador: crea los productos first_id..count (arrival = id-1) con svc_ms
+   predefinidos. first_id = 1 salvo al reanudar desde un checkpoint. */
+void generator_process(int out_fd, int first_id, int count,
                        const StationConfig svc_all[NSTAGES]);
 
 /* Estaciones con cola interna (lector + worker único):
    - station1 fija epoch_s al primer ingreso de producto.
    - station2 y station3 usan el epoch ya fijado.
-   - La política se elige por StationConfig (FCFS o RR). */
-void station1_with_queue(int in_fd, int out_fd, StationConfig cfg);
-void station2_with_queue(int in_fd, int out_fd, StationConfig cfg);
-void station3_with_queue_and_metrics(int in_fd, StationConfig cfg);
+   - La política se elige por StationConfig (FCFS o RR).
+   - ck: checkpoints periódicos y, con ck->resume, arranque desde snapshot.
+   - mc (E3): contraste con el modelo analítico y planificador de capacidad. */
+void station1_with_queue(int in_fd, int out_fd, StationConfig cfg, const CkptConfig *ck);
+void station2_with_queue(int in_fd, int out_fd, StationConfig cfg, const CkptConfig *ck);
+void station3_with_queue_and_metrics(int in_fd, StationConfig cfg, const CkptConfig *ck,
+                                     const ModelConfig *mc);
 
 #endif /* STATION_H */
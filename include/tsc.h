@@ -0,0 +1,54 @@
+#ifndef TSC_H
+#define TSC_H
+
+#include <stdint.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TSC_HAVE_RDTSC 1
+#endif
+
+/*
+ * Marcas de tiempo baratas para el camino caliente (slices, t_in/t_out, LOG).
+ *
+ * Un "tick" es una lectura del TSC invariante. Se calibra UNA vez contra
+ * CLOCK_MONOTONIC en el padre, antes de los fork(): generador y estaciones
+ * heredan la misma escala, y como el TSC invariante es común a todos los
+ * núcleos, los ticks de un proceso son comparables con los de otro.
+ * Si la CPU no ofrece TSC invariante, un tick es 1 ns de CLOCK_MONOTONIC.
+ *
+ * Regla: se guardan ticks enteros; la conversión a segundos se hace solo al
+ * reportar (tk_to_s / tk_mono_s).
+ */
+typedef uint64_t tick_t;
+
+typedef struct {
+    int    use_tsc;      // 1 = rdtsc; 0 = respaldo clock_gettime (ns)
+    double hz;           // ticks por segundo
+    double s_per_tick;   // 1/hz
+    tick_t tk0;          // tick en el instante de calibración
+    double mono0_s;      // CLOCK_MONOTONIC (s) en ese mismo instante
+} TscClock;
+
+extern TscClock g_tsc;
+
+void tsc_calibrate(void);     // llamar en el padre antes de fork()
+void tsc_bench(int iters);    // microbenchmark tk_now() vs now_s()
+
+static inline tick_t tk_now(void){
+#ifdef TSC_HAVE_RDTSC
+    if (g_tsc.use_tsc) return (tick_t)__rdtsc();
+#endif
+    struct timespec ts; clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (tick_t)ts.tv_sec * 1000000000ull + (tick_t)ts.tv_nsec;
+}
+/* duración en ticks -> segundos */
+static inline double tk_to_s(int64_t dt){ return (double)dt * g_tsc.s_per_tick; }
+/* segundos -> duración en ticks */
+static inline int64_t s_to_tk(double s){ return (int64_t)(s * g_tsc.hz); }
+/* tick absoluto -> segundos de CLOCK_MONOTONIC (misma escala que now_s()) */
+static inline double tk_mono_s(tick_t t){
+    return g_tsc.mono0_s + tk_to_s((int64_t)(t - g_tsc.tk0));
+}
+
+#endif /* TSC_H */
@@ -0,0 +1,279 @@
+#define _GNU_SOURCE
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include "ckpt.h"
+#include "ipc.h"
+#include "model.h"
+
+#define CKPT_MAX_SECS 8
+
+static void station_path(const CkptConfig *ck, int station, uint32_t seq, char *out, size_t n)
+{
+    snprintf(out, n, "%s/station%d.%u.ckpt", ck->dir, station + 1, seq);
+}
+
+/* fsync de la carpeta: hace durable el rename (la entrada del directorio) */
+static int fsync_dir(const CkptConfig *ck)
+{
+    int fd = open(ck->dir, O_RDONLY | O_DIRECTORY);
+    if (fd < 0)
+    {
+        perror("open ckpt dir");
+        return -1;
+    }
+    int rc = fsync(fd);
+    if (rc < 0)
+        perror("fsync ckpt dir");
+    close(fd);
+    return rc;
+}
+
+int ckpt_init_dir(const CkptConfig *ck)
+{
+    if (mkdir(ck->dir, 0755) < 0 && errno != EEXIST)
+    {
+        perror("mkdir ckpt");
+        return -1;
+    }
+    return 0;
+}
+
+/* Escribe header + secciones en un .tmp, lo sincroniza y lo renombra (rename
+   es atómico: nunca queda un snapshot a medias con el nombre definitivo); el
+   fsync de la carpeta asegura que el rename sobreviva a un corte de luz
+   antes de que el marcador siga hacia abajo. */
+int ckpt_save(const CkptConfig *ck, const CkptHeader *h,
+              const CkptSection *secs, int nsecs, size_t *bytes)
+{
+    char path[128], tmp[136];
+    station_path(ck, (int)h->station, h->seq, path, sizeof(path));
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+
+    int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        perror("open ckpt");
+        return -1;
+    }
+    struct iovec iov[1 + CKPT_MAX_SECS];
+    int n = 0;
+    size_t total = sizeof(*h);
+    iov[n++] = (struct iovec){(void *)h, sizeof(*h)};
+    for (int i = 0; i < nsecs && i < CKPT_MAX_SECS; i++)
+    {
+        if (secs[i].len == 0)
+            continue;
+        iov[n++] = (struct iovec){(void *)secs[i].ptr, secs[i].len};
+        total += secs[i].len;
+    }
+    ssize_t k = writev(fd, iov, n);
+    if (k < 0 || (size_t)k != total)
+    {
+        // writev corto en un archivo regular: reintentar con write_full
+        if (k < 0)
+            k = 0;
+        size_t skip = (size_t)k;
+        for (int i = 0; i < n; i++)
+        {
+            if (skip >= iov[i].iov_len)
+            {
+                skip -= iov[i].iov_len;
+                continue;
+            }
+            write_full(fd, (char *)iov[i].iov_base + skip, iov[i].iov_len - skip);
+            skip = 0;
+        }
+    }
+    if (fsync(fd) < 0)
+    {
+        perror("fsync ckpt");
+        close(fd);
+        return -1;
+    }
+    close(fd);
+    if (rename(tmp, path) < 0)
+    {
+        perror("rename ckpt");
+        return -1;
+    }
+    if (fsync_dir(ck) < 0)
+        return -1;
+    if (bytes)
+        *bytes = total;
+    return 0;
+}
+
+/* Devuelve el payload (todo lo que sigue al header) en memoria de malloc y
+   su largo en *len (NULL si no interesa), para que quien lo interprete lo
+   valide contra nq/nslices/nrecs. */
+void *ckpt_load(const CkptConfig *ck, int station, uint32_t seq, CkptHeader *h, size_t *len_out)
+{
+    char path[128];
+    station_path(ck, station, seq, path, sizeof(path));
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        perror(path);
+        return NULL;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(*h) ||
+        !read_full(fd, h, sizeof(*h)) ||
+        h->magic != CKPT_MAGIC || h->version != CKPT_VERSION ||
+        h->station != (uint32_t)station || h->seq != seq)
+    {
+        fprintf(stderr, "%s: snapshot inválido\n", path);
+        close(fd);
+        return NULL;
+    }
+    size_t len = (size_t)st.st_size - sizeof(*h);
+    void *buf = malloc(len ? len : 1);
+    if (!buf || (len && !read_full(fd, buf, len)))
+    {
+        fprintf(stderr, "%s: snapshot truncado\n", path);
+        free(buf);
+        close(fd);
+        return NULL;
+    }
+    close(fd);
+    if (len_out)
+        *len_out = len;
+    return buf;
+}
+
+int ckpt_commit(const CkptConfig *ck, uint32_t seq, int head)
+{
+    char path[128], tmp[136];
+    snprintf(path, sizeof(path), "%s/committed", ck->dir);
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    FILE *f = fopen(tmp, "w");
+    if (!f)
+    {
+        perror("fopen committed");
+        return -1;
+    }
+    fprintf(f, "%u %d\n", seq, head);
+    if (fflush(f) != 0 || fsync(fileno(f)) < 0)
+    {
+        perror("fsync committed");
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+    if (rename(tmp, path) < 0)
+    {
+        perror("rename committed");
+        return -1;
+    }
+    return fsync_dir(ck);
+}
+
+int ckpt_committed(const CkptConfig *ck, uint32_t *seq, int *head)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "%s/committed", ck->dir);
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return -1;
+    int h = 0;
+    int ok = fscanf(f, "%u %d", seq, &h) == 2 && h >= 0 && h < NSTAGES;
+    if (head)
+        *head = h;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+/* Borra "<dir>/stationN.<seq>.ckpt" con seq < below_seq (station < 0: todas). */
+static void prune_dir(const CkptConfig *ck, int station, uint32_t below_seq)
+{
+    DIR *d = opendir(ck->dir);
+    if (!d)
+        return;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL)
+    {
+        int s;
+        unsigned seq;
+        char tail[8] = "";
+        if (sscanf(e->d_name, "station%d.%u.%7s", &s, &seq, tail) != 3 ||
+            strcmp(tail, "ckpt") != 0)
+            continue;
+        if ((station < 0 || s == station + 1) && seq < below_seq)
+        {
+            char path[320];
+            snprintf(path, sizeof(path), "%s/%s", ck->dir, e->d_name);
+            unlink(path);
+        }
+    }
+    closedir(d);
+}
+
+void ckpt_prune(const CkptConfig *ck, int station, uint32_t below_seq)
+{
+    prune_dir(ck, station, below_seq);
+}
+
+/* Lee el seq confirmado y los snapshots de ese corte para fijar el generador
+   (header de la cabeza) y un epoch nuevo: el snapshot más tardío del corte
+   (el de E3, que confirma) pasa a ser "ahora". Así el tiempo caído no cuenta
+   en TAT/WT, ningún reloj de estación retrocede al reanudar, y los ticks (que
+   no sobreviven a un reinicio del contenedor) se rehacen sobre esta
+   calibración. */
+int ckpt_prepare_resume(CkptConfig *ck)
+{
+    tick_t t0 = tk_now();
+    uint32_t seq;
+    int head;
+    if (ckpt_committed(ck, &seq, &head) < 0)
+    {
+        fprintf(stderr, "resume: no hay snapshot confirmado en %s\n", ck->dir);
+        return -1;
+    }
+    int32_t next_id = 1;
+    int64_t last = -1; // ticks (de este proceso) desde epoch al último snapshot
+    for (int s = head; s < NSTAGES; s++)
+    {
+        CkptHeader h;
+        void *buf = ckpt_load(ck, s, seq, &h, NULL);
+        if (!buf)
+            return -1;
+        free(buf);
+        if (s == head)
+            next_id = h.next_id;
+        if (h.epoch_tk)
+        {
+            int64_t rel = ckpt_rescale(&h, (int64_t)(h.taken_tk - h.epoch_tk));
+            if (rel > last)
+                last = rel;
+        }
+    }
+
+    ck->seq = seq;
+    ck->head = head;
+    ck->next_id = next_id;
+    ck->epoch_tk = (last >= 0) ? tk_now() - (tick_t)last : 0;
+    LOG("parent", "resume desde snapshot #%u (cabeza E%d, generador desde P#%02d) en %.3f ms",
+        seq, head + 1, ck->next_id, tk_to_s((int64_t)(tk_now() - t0)) * 1e3);
+    return 0;
+}
+
+void ckpt_clear(const CkptConfig *ck)
+{
+    char path[128];
+    snprintf(path, sizeof(path), "%s/committed", ck->dir);
+    unlink(path);
+    prune_dir(ck, -1, UINT32_MAX);
+    for (int s = 0; s < NSTAGES; s++)
+    {
+        station_path(ck, s, CKPT_SEQ_FINAL, path, sizeof(path));
+        unlink(path);
+    }
+    stats_clear();
+}
@@ -1,10 +1,14 @@
 #include <unistd.h>
 #include <sys/wait.h>
 #include <stdlib.h>
+#include <string.h>
 #include "product.h"
 #include "ipc.h"
 #include "station.h"
 #include "policy.h"
+#include "tsc.h"
+#include "ckpt.h"
+#include "model.h"
 
 /*
  * Flujo con colas:
@@ -13,16 +17,40 @@
  * Política por estación (elige aquí FCFS o RR y quantum):
  *  - En RR, el worker "rebana" y re-encola si hay remanente.
  *  - Siempre hay UN solo worker por estación => solo un producto en proceso.
+ *
+ * Uso: ./app                 simulación normal (con checkpoints periódicos)
+ *      ./app --resume        reconstruye la línea desde el último checkpoint
+ *      ./app --target=X      throughput objetivo (prod/s) para el planificador
+ *      ./app --bench-clock   microbenchmark tk_now() (TSC) vs now_s()
  */
-int main(void){
+int main(int argc, char **argv){
     setvbuf(stdout, NULL, _IONBF, 0);
 
+    // Calibrar el TSC ANTES de fork(): todos los hijos heredan la misma escala
+    tsc_calibrate();
+    // Checkpoints: E1 inicia uno cada interval_ms; ver ckpt.h
+    CkptConfig ck = { .interval_ms = 1000, .dir = "/tmp/assembly_ckpt", .next_id = 1 };
+    // Modelo analítico en E3: capacidad para target_tput con ρ ≤ rho_max por worker
+    ModelConfig mc = { .target_tput = 2.0, .rho_max = 0.85 };
+    for(int i = 1; i < argc; i++){
+        if(strcmp(argv[i], "--bench-clock") == 0){
+            tsc_bench(/*iters=*/1000000);
+            return 0;
+        }
+        if(strcmp(argv[i], "--resume") == 0) ck.resume = 1;
+        if(strncmp(argv[i], "--target=", 9) == 0) mc.target_tput = atof(argv[i] + 9);
+    }
+    if(ckpt_init_dir(&ck) < 0) return 1;
+    if(ck.resume && ckpt_prepare_resume(&ck) < 0) return 1;
+    if(!ck.resume) ckpt_clear(&ck); // corrida nueva: descartar snapshots viejos
+
     // Config de estaciones (E1 FCFS 400ms; E2 RR 600ms q=200; E3 RR 300ms q=200)
     StationConfig cfg[NSTAGES] = {
         { .policy = POL_RR, .work_ms = 400, .quantum_ms = 100   }, // E1
         { .policy = POL_RR,   .work_ms = 600, .quantum_ms = 200 }, // E2
         { .policy = POL_RR,   .work_ms = 300, .quantum_ms = 200 }  // E3
     };
+    memcpy(mc.cfg, cfg, sizeof(cfg)); // política real de cada estación para el modelo
 
 
     int A[2], B[2], C[2];
@@ -34,7 +62,7 @@ int main(void){
     if(g<0){ perror("fork gen"); return 1; }
     if(g==0){
         close(A[0]); close(B[0]); close(B[1]); close(C[0]); close(C[1]);
-        generator_process(A[1], /*count=*/10, cfg);
+        generator_process(A[1], ck.next_id, /*count=*/10, cfg);
     }
     LOG("parent","generator pid=%d",(int)g);
 
@@ -43,7 +71,7 @@ int main(void){
     if(s1<0){ perror("fork s1"); return 1; }
     if(s1==0){
         close(A[1]); close(B[0]); close(C[0]); close(C[1]);
-        station1_with_queue(A[0], B[1], cfg[0]);
+        station1_with_queue(A[0], B[1], cfg[0], &ck);
     }
     LOG("parent","station1 pid=%d",(int)s1);
 
@@ -52,7 +80,7 @@ int main(void){
     if(s2<0){ perror("fork s2"); return 1; }
     if(s2==0){
         close(A[0]); close(A[1]); close(B[1]); close(C[0]);
-        station2_with_queue(B[0], C[1], cfg[1]);
+        station2_with_queue(B[0], C[1], cfg[1], &ck);
     }
     LOG("parent","station2 pid=%d",(int)s2);
 
@@ -61,15 +89,22 @@ int main(void){
     if(s3<0){ perror("fork s3"); return 1; }
     if(s3==0){
         close(A[0]); close(A[1]); close(B[0]); close(B[1]); close(C[1]);
-        station3_with_queue_and_metrics(C[0], cfg[2]);
+        station3_with_queue_and_metrics(C[0], cfg[2], &ck, &mc);
     }
     LOG("parent","station3 pid=%d",(int)s3);
 
     // --- cerrar y esperar ---
     close(A[0]); close(A[1]); close(B[0]); close(B[1]); close(C[0]); close(C[1]);
     LOG("parent","cierro FDs; esperando hijos...");
-    int st;
-    while (wait(&st) > 0) {}
-    LOG("parent","todos terminaron");
+    int st, ok = 1;
+    while (wait(&st) > 0) {
+        if(!WIFEXITED(st) || WEXITSTATUS(st) != 0) ok = 0;
+    }
+    if(ok){
+        ckpt_clear(&ck); // corrida completa: los snapshots ya no sirven
+        LOG("parent","todos terminaron");
+    } else {
+        LOG("parent","algún proceso terminó mal; reanudar con ./app --resume");
+    }
     return 0;
 }
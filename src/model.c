@@ -0,0 +1,243 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "model.h"
+
+/* ------------------ Persistencia de estadísticas por estación ------------------ */
+
+static void stats_path(int idx, char *out, size_t n)
+{
+    snprintf(out, n, "/tmp/assembly_station%d.stats", idx + 1);
+}
+
+int stats_save(const StationStats *st)
+{
+    char path[64];
+    stats_path(st->idx, path, sizeof(path));
+    FILE *f = fopen(path, "wb");
+    if (!f)
+    {
+        perror("fopen stats");
+        return -1;
+    }
+    int ok = fwrite(st, sizeof(*st), 1, f) == 1;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+int stats_load(int idx, StationStats *st)
+{
+    char path[64];
+    stats_path(idx, path, sizeof(path));
+    FILE *f = fopen(path, "rb");
+    if (!f)
+        return -1;
+    int ok = fread(st, sizeof(*st), 1, f) == 1 && st->idx == idx;
+    fclose(f);
+    return ok ? 0 : -1;
+}
+
+void stats_clear(void)
+{
+    char path[64];
+    for (int i = 0; i < NSTAGES; i++)
+    {
+        stats_path(i, path, sizeof(path));
+        unlink(path);
+    }
+}
+
+/* ------------------ Fórmulas ------------------ */
+
+/* Probabilidad de espera de Erlang C para M/M/c con carga a = λ·S */
+static double erlang_c(int c, double a)
+{
+    double rho = a / c;
+    if (rho >= 1.0)
+        return 1.0;
+    double term = 1.0, sum = 1.0; // a^k/k!, k=0..c-1
+    for (int k = 1; k < c; k++)
+    {
+        term *= a / k;
+        sum += term;
+    }
+    double top = term * a / c / (1.0 - rho); // a^c/c! · 1/(1-ρ)
+    return top / (sum + top);
+}
+
+static double wq_mmc(int c, double lambda, double s)
+{
+    double a = lambda * s;
+    if (a / c >= 1.0)
+        return INFINITY;
+    return erlang_c(c, a) * s / (c * (1.0 - a / c));
+}
+
+static int cmp_double(const void *a, const void *b)
+{
+    double d = *(const double *)a - *(const double *)b;
+    return (d > 0) - (d < 0);
+}
+
+/* λ y ca² (coef. de variación² de entrellegadas) a partir de instantes de llegada */
+static void arrival_rate(double *t, int n, double *lambda, double *ca2)
+{
+    *lambda = 0.0;
+    *ca2 = 0.0;
+    if (n < 2)
+        return;
+    qsort(t, n, sizeof(double), cmp_double);
+    double mean = (t[n - 1] - t[0]) / (n - 1);
+    if (mean <= 0.0)
+        return;
+    double var = 0.0;
+    for (int k = 1; k < n; k++)
+    {
+        double d = (t[k] - t[k - 1]) - mean;
+        var += d * d;
+    }
+    var /= (n - 1);
+    *lambda = 1.0 / mean;
+    *ca2 = var / (mean * mean);
+}
+
+static void print_wq(const char *name, double wq)
+{
+    if (isinf(wq))
+        printf("%s=saturada", name);
+    else
+        printf("%s=%.3fs", name, wq);
+}
+
+/* ------------------ Reporte ------------------ */
+
+void model_report(const ModelRec *recs, int n,
+                  const StationStats st[NSTAGES], const ModelConfig *mc)
+{
+    printf("\n===== MODELO vs MEDIDO (%d productos) =====\n", n);
+    if (n == 0)
+    {
+        printf("(sin datos)\n");
+        return;
+    }
+    double *a = malloc(sizeof(double) * (size_t)n);
+    if (!a)
+        return;
+
+    // λ de la línea: en estado estable es el mismo en todas las estaciones.
+    // Las salidas de arriba llegan en ráfagas (una estación saturada las
+    // suelta juntas); eso solo se refleja en ca², no en ρ.
+    double lambda = 0.0, ca2_line = 0.0;
+    for (int k = 0; k < n; k++)
+        a[k] = recs[k].arrival;
+    arrival_rate(a, n, &lambda, &ca2_line);
+
+    double s_mean[NSTAGES];
+    for (int i = 0; i < NSTAGES; i++)
+    {
+        // Llegada del modelo: E1 = llegada simulada; Ei = salida de E(i-1)
+        double s = 0.0, s2 = 0.0, w = 0.0, lat = 0.0;
+        for (int k = 0; k < n; k++)
+        {
+            double ai = (i == 0) ? recs[k].arrival : recs[k].t_out[i - 1];
+            a[k] = ai;
+            s += recs[k].svc_s[i];
+            s2 += recs[k].svc_s[i] * recs[k].svc_s[i];
+            w += recs[k].t_out[i] - ai;
+            lat += recs[k].t_arr[i] - ai; // pipe (o gate en E1) hasta la cola
+        }
+        s /= n;
+        s2 /= n;
+        w /= n;
+        lat /= n;
+        s_mean[i] = s;
+        double cs2 = (s > 0.0) ? (s2 - s * s) / (s * s) : 0.0;
+        if (cs2 < 0.0)
+            cs2 = 0.0;
+        double lambda_up, ca2;
+        arrival_rate(a, n, &lambda_up, &ca2); // ca² de las entrellegadas reales
+
+        double rho = lambda * s;
+        double wq = w - s;
+        double wq_mm1 = INFINITY, wq_mg1 = INFINITY, wq_gg1 = INFINITY, wq_ps = INFINITY;
+        if (rho < 1.0)
+        {
+            wq_mm1 = rho * s / (1.0 - rho);
+            wq_mg1 = rho * s * (1.0 + cs2) / (2.0 * (1.0 - rho));
+            wq_gg1 = rho / (1.0 - rho) * (ca2 + cs2) / 2.0 * s;
+            wq_ps = rho * s / (1.0 - rho); // M/G/1-PS: W = S/(1-ρ)
+        }
+        const StationConfig *cfg = &st[i].cfg;
+        int is_rr = (cfg->policy == POL_RR);
+
+        printf("E%d %s", i + 1, is_rr ? "RR" : "FCFS");
+        if (is_rr)
+            printf("(q=%dms)", cfg->quantum_ms);
+        printf(" | S=%.3fs cs²=%.2f | λ=%.3f/s ca²=%.2f | ρ=%.3f", s, cs2, lambda, ca2, rho);
+        if (st[i].span_s > 0.0)
+            printf(" U=%.3f", st[i].busy_s / st[i].span_s);
+        printf("\n");
+
+        // Little: L (contador de la estación) vs λ·W (registros por producto)
+        if (st[i].span_s > 0.0 && st[i].n_done > 0)
+        {
+            double L = st[i].area_s / st[i].span_s;
+            double lw = (st[i].n_done / st[i].span_s) * w;
+            printf("   Little: L=%.3f  λ·W=%.3f (desvío %+.1f%%)  latencia %s=%.3fs\n",
+                   L, lw, (L > 0.0) ? (lw - L) / L * 100.0 : 0.0,
+                   (i == 0) ? "gate" : "pipe", lat);
+        }
+        else
+        {
+            printf("   Little: sin estadísticas de la estación\n");
+        }
+
+        printf("   Wq medido=%.3fs | ", wq);
+        print_wq("M/M/1", wq_mm1);
+        printf("  ");
+        print_wq("M/G/1", wq_mg1);
+        printf("  ");
+        print_wq("G/G/1", wq_gg1);
+        printf("  ");
+        print_wq("PS", wq_ps);
+        printf("\n");
+
+        // Modelo de referencia: FCFS → Kingman (G/G/1); RR → procesador compartido
+        double wq_ref = is_rr ? wq_ps : wq_gg1;
+        if (isinf(wq_ref))
+        {
+            printf("   modelo %s: estación saturada (ρ≥1), no hay estado estable\n",
+                   is_rr ? "PS" : "G/G/1");
+        }
+        else
+        {
+            double w_ref = wq_ref + s;
+            printf("   modelo %s: W=%.3fs medido W=%.3fs → desvío %+.3fs (%+.1f%%)\n",
+                   is_rr ? "PS" : "G/G/1", w_ref, w, w - w_ref,
+                   (w_ref > 0.0) ? (w - w_ref) / w_ref * 100.0 : 0.0);
+        }
+    }
+    free(a);
+
+    // Planificador: workers por estación para sostener target_tput con ρ ≤ rho_max
+    double lt = mc->target_tput;
+    printf("--- Capacidad para X=%.3f prod/s (ρ por worker ≤ %.2f) ---\n", lt, mc->rho_max);
+    int bott = 0;
+    for (int i = 0; i < NSTAGES; i++)
+    {
+        if (s_mean[i] > s_mean[bott])
+            bott = i;
+        double load = lt * s_mean[i];
+        int c = 1;
+        while (load / c > mc->rho_max && c < 1024)
+            c++;
+        printf("E%d: S=%.3fs carga=%.3f → workers=%d (ρ=%.3f, ", i + 1, s_mean[i], load, c, load / c);
+        print_wq("Wq M/M/c", wq_mmc(c, lt, s_mean[i]));
+        printf(")\n");
+    }
+    if (s_mean[bott] > 0.0)
+        printf("Cuello de botella actual: E%d (X máx con 1 worker = %.3f prod/s)\n",
+               bott + 1, 1.0 / s_mean[bott]);
+    printf("=========================================\n");
+}
@@ -21,12 +21,24 @@ void q_push(ProductQueue* q, const Product* p){
     pthread_mutex_unlock(&q->mtx);
     sem_post(&q->sem_items);
 }
-void q_pop(ProductQueue* q, Product* out){
+int q_pop(ProductQueue* q, Product* out){
     sem_wait(&q->sem_items);
     pthread_mutex_lock(&q->mtx);
+    if(q->size == 0){ // despertado sin elemento (EOF del lector)
+        pthread_mutex_unlock(&q->mtx);
+        return 0;
+    }
     *out = q->buf[q->head];
     q->head = (q->head + 1) % QCAP;
     q->size--;
     pthread_mutex_unlock(&q->mtx);
     sem_post(&q->sem_space);
+    return 1;
+}
+int q_snapshot(ProductQueue* q, Product* out, int max){
+    pthread_mutex_lock(&q->mtx);
+    int n = q->size < max ? q->size : max;
+    for(int i=0;i<n;i++) out[i] = q->buf[(q->head + i) % QCAP];
+    pthread_mutex_unlock(&q->mtx);
+    return n;
 }
@@ -6,7 +6,9 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include "ckpt.h"
 #include "ipc.h"
+#include "model.h"
 #include "queue.h"
 #include "station.h"
 #include "policy.h"
@@ -19,13 +21,19 @@ static inline double total_burst_s(const Product *p)
 {
     return (p->svc_ms[0] + p->svc_ms[1] + p->svc_ms[2]) / 1000.0; // ms → s
 }
+/* tick absoluto → segundos relativos a epoch (solo al reportar) */
+static inline double rel_s(const Product *p, tick_t t)
+{
+    return tk_to_s((int64_t)(t - p->epoch_tk));
+}
 
 /* =================== GENERADOR =================== */
-/* Carga bursts por estación desde cfg y setea rem_ms = svc_ms (para RR) */
-void generator_process(int out_fd, int count, const StationConfig svc_all[NSTAGES])
+/* Carga bursts por estación desde cfg y setea rem_ms = svc_ms (para RR).
+   first_id > 1 solo al reanudar: los anteriores ya están en los snapshots. */
+void generator_process(int out_fd, int first_id, int count, const StationConfig svc_all[NSTAGES])
 {
-    LOG("generator", "inicio out=%d count=%d", out_fd, count);
-    for (int i = 0; i < count; i++)
+    LOG("generator", "inicio out=%d first=%d count=%d", out_fd, first_id, count);
+    for (int i = first_id - 1; i < count; i++)
     {
         Product p = (Product){0};
         p.id = i + 1;
@@ -38,6 +46,9 @@ void generator_process(int out_fd, int count, const StationConfig svc_all[NSTAGE
         write_full(out_fd, &p, sizeof(Product));
         LOG("generator", "enviado Product #%02d (arrival=%.0f)", p.id, p.arrival_s);
     }
+    Product fin;
+    ckpt_eos(&fin);
+    write_full(out_fd, &fin, sizeof(Product));
     LOG("generator", "EOF out=%d", out_fd);
     close(out_fd);
     exit(0);
@@ -51,11 +62,48 @@ typedef struct
     StationConfig cfg; // {policy, work_ms, quantum_ms}
     ProductQueue *q;
     atomic_int *done; // lector terminó (EOF)
+    atomic_int eos;   // arriba mandó FIN antes del EOF (no se cayó)
     // epoch global (solo lo fija E1 al primer ingreso)
     atomic_int *epoch_set; // 0->no fijado; 1->fijado
-    double *epoch_value;   // valor del epoch (CLOCK_MONOTONIC)
+    tick_t *epoch_value;   // valor del epoch (ticks, ver tsc.h); solo el worker lo toca
+    // checkpoints (ver ckpt.h)
+    const CkptConfig *ck;
+    sem_t ck_ack;        // E2/E3: el lector espera a que el worker tome el snapshot
+    uint32_t ck_seq;     // último seq tomado
+    tick_t ck_next_tk;   // cabeza: cuándo iniciar el próximo
+    int32_t max_id;      // mayor id sacado por el worker (cursor del generador)
+    int ck_n;
+    double ck_pause_sum_s, ck_pause_max_s;
+    // estadísticas para el modelo (model.h), en ticks
+    pthread_mutex_t st_mtx;
+    int st_n;            // productos en la estación (cola + servicio)
+    int st_done;         // productos que salieron
+    tick_t st_last_tk;   // último cambio de st_n
+    tick_t st_first_tk;  // primera llegada
+    tick_t st_end_tk;    // última salida
+    int64_t st_area_tk;  // ∫ st_n dt
+    int64_t st_busy_tk;  // tiempo en slices (solo el worker)
 } StationCtx;
 
+/* Llega (+1) o sale (-1) un producto de la estación: integra N(t) */
+static void st_change(StationCtx *cx, int delta)
+{
+    pthread_mutex_lock(&cx->st_mtx);
+    tick_t now = tk_now();
+    if (cx->st_first_tk == 0)
+        cx->st_first_tk = now;
+    if (cx->st_last_tk != 0)
+        cx->st_area_tk += (int64_t)cx->st_n * (int64_t)(now - cx->st_last_tk);
+    cx->st_last_tk = now;
+    cx->st_n += delta;
+    if (delta < 0)
+    {
+        cx->st_end_tk = now;
+        cx->st_done++;
+    }
+    pthread_mutex_unlock(&cx->st_mtx);
+}
+
 /* Lector: consume del pipe y encola */
 static void *th_reader(void *arg)
 {
@@ -63,8 +111,25 @@ static void *th_reader(void *arg)
     Product p;
     while (read_full(cx->in_fd, &p, sizeof(Product)))
     {
+        if (ckpt_is_eos(&p))
+        {
+            atomic_store(&cx->eos, 1);
+            continue;
+        }
+        // E2/E3: llegada a la cola (en E1 cuenta al pasar el gate)
+        if (cx->idx > 0 && !ckpt_is_marker(&p))
+        {
+            p.t_arr_tk[cx->idx] = tk_now();
+            st_change(cx, +1);
+        }
         q_push(cx->q, &p);
+        // marcador: no leer más del pipe hasta que el worker tome el snapshot
+        if (ckpt_is_marker(&p))
+            sem_wait(&cx->ck_ack);
     }
+    if (!atomic_load(&cx->eos))
+        LOG((cx->idx == 0) ? "station1" : (cx->idx == 1) ? "station2" : "station3",
+            "EOF sin FIN: la etapa anterior se cayó");
     atomic_store(cx->done, 1);
     sem_post(&cx->q->sem_items); // despertar worker si espera
     return NULL;
@@ -74,19 +139,19 @@ static void *th_reader(void *arg)
 typedef struct
 {
     int id;
-    double t0, t1;
+    int64_t t0, t1; // ticks relativos a epoch
 } Slice;
 static Slice g_slices[MAX_SLICES];
 static int g_nslices = 0;
 
-static void gantt_add(int id, double t0, double t1)
+static void gantt_add(int id, int64_t t0, int64_t t1)
 {
     if (g_nslices < MAX_SLICES)
         g_slices[g_nslices++] = (Slice){id, t0, t1};
 }
 static int cmp_slice(const void *a, const void *b)
 {
-    double d = ((const Slice *)a)->t0 - ((const Slice *)b)->t0;
+    int64_t d = ((const Slice *)a)->t0 - ((const Slice *)b)->t0;
     return (d > 0) - (d < 0);
 }
 static void gantt_print(int station_idx)
@@ -103,7 +168,7 @@ static void gantt_print(int station_idx)
     for (int i = 0; i < n; i++)
     {
         printf("%.3f–%.3f P%d%s",
-               g_slices[i].t0, g_slices[i].t1, g_slices[i].id,
+               tk_to_s(g_slices[i].t0), tk_to_s(g_slices[i].t1), g_slices[i].id,
                (i + 1 < n) ? " | " : "\n");
     }
 }
@@ -113,7 +178,7 @@ typedef struct
 {
     int id;
     double arrival; // arrival_s
-    double t_in[3], t_out[3];
+    int64_t t_arr[3], t_in[3], t_out[3]; // ticks relativos a epoch
     int svc_ms[3]; // bursts por estación
 } Rec;
 
@@ -131,11 +196,17 @@ static int g_n_done_total = 0;
 static void print_metrics(const Product *p)
 {
     // Duración real por estación (para verificación)
-    double e1 = p->t_out_s[0] - p->t_in_s[0];
-    double e2 = p->t_out_s[1] - p->t_in_s[1];
-    double e3 = p->t_out_s[2] - p->t_in_s[2];
+    double in[3], out[3];
+    for (int s = 0; s < 3; ++s)
+    {
+        in[s] = rel_s(p, p->t_in_tk[s]);
+        out[s] = rel_s(p, p->t_out_tk[s]);
+    }
+    double e1 = out[0] - in[0];
+    double e2 = out[1] - in[1];
+    double e3 = out[2] - in[2];
 
-    double tat_total = p->t_out_s[2] - p->arrival_s; // desde llegada hasta salida E3
+    double tat_total = out[2] - p->arrival_s; // desde llegada hasta salida E3
     double wt_total = tat_total - total_burst_s(p);  // TAT - (sum bursts por estación)
     if (wt_total < 0)
         wt_total = 0.0;
@@ -144,9 +215,9 @@ static void print_metrics(const Product *p)
            "E1[%.3f→%.3f](%.3fs)  E2[%.3f→%.3f](%.3fs)  E3[%.3f→%.3f](%.3fs)  "
            "| TAT=%.3fs  WT=%.3fs\n",
            p->id, p->arrival_s,
-           p->t_in_s[0], p->t_out_s[0], e1,
-           p->t_in_s[1], p->t_out_s[1], e2,
-           p->t_in_s[2], p->t_out_s[2], e3,
+           in[0], out[0], e1,
+           in[1], out[1], e2,
+           in[2], out[2], e3,
            tat_total, wt_total);
 }
 
@@ -233,6 +304,177 @@ static void print_all_stations_ids_together(void)
     printf("\n");
 }
 
+/* ------------------ Checkpoints (snapshot / restore) ------------------ */
+
+/* seg. relativos a epoch de un tick de la estación (-1 = sin marcar) */
+static double st_rel_s(const StationCtx *cx, tick_t t)
+{
+    return (t && *cx->epoch_value) ? tk_to_s((int64_t)(t - *cx->epoch_value)) : -1.0;
+}
+
+/* Serializa cola + Gantt + agregados + estadísticas como snapshot 'seq' */
+static int ckpt_save_state(StationCtx *cx, uint32_t seq, tick_t t0, int *nq_out, size_t *bytes)
+{
+    static Product qbuf[QCAP];
+
+    int nq = q_snapshot(cx->q, qbuf, QCAP);
+    int nmark = 0;
+    int32_t next_id = cx->max_id + 1;
+    for (int i = 0; i < nq; i++)
+    {
+        if (ckpt_is_marker(&qbuf[i]))
+            continue; // marcadores no se persisten
+        if (qbuf[i].id >= next_id)
+            next_id = qbuf[i].id + 1;
+        if (*cx->epoch_value == 0 && qbuf[i].epoch_tk != 0)
+            *cx->epoch_value = qbuf[i].epoch_tk; // aún no sacó ninguno: el de la cola
+        qbuf[nmark++] = qbuf[i];
+    }
+
+    CkptHeader h = {
+        .magic = CKPT_MAGIC, .version = CKPT_VERSION,
+        .station = (uint32_t)cx->idx, .seq = seq,
+        .nq = (uint32_t)nmark, .nslices = (uint32_t)g_nslices,
+        .nrecs = (uint32_t)g_rec_len, .next_id = next_id,
+        .hz = g_tsc.hz, .epoch_tk = *cx->epoch_value, .taken_tk = t0,
+        .sum_tat = g_sum_tat_total, .sum_wait = g_sum_wait_total,
+        .n_done = g_n_done_total, .st_done = cx->st_done};
+    pthread_mutex_lock(&cx->st_mtx);
+    h.st_area_s = tk_to_s(cx->st_area_tk + (int64_t)cx->st_n * (int64_t)(t0 - cx->st_last_tk) *
+                                               (cx->st_last_tk != 0));
+    h.st_first_s = st_rel_s(cx, cx->st_first_tk);
+    h.st_end_s = st_rel_s(cx, cx->st_end_tk);
+    h.st_done = cx->st_done;
+    pthread_mutex_unlock(&cx->st_mtx);
+    h.st_busy_s = tk_to_s(cx->st_busy_tk);
+    CkptSection secs[] = {
+        {qbuf, sizeof(Product) * (size_t)nmark},
+        {g_slices, sizeof(Slice) * (size_t)g_nslices},
+        {g_recs, sizeof(Rec) * (size_t)g_rec_len},
+        {g_finish_order, sizeof(int) * (size_t)g_finish_len},
+        {g_finish_time, sizeof(double) * (size_t)g_finish_len}};
+    *nq_out = nmark;
+    return ckpt_save(cx->ck, &h, secs, 5, bytes);
+}
+
+/* Se llama desde el worker entre slices: no hay producto en servicio y, en
+   E2/E3, el lector está detenido en el marcador. Pausa = copia + escritura. */
+static void ckpt_take(StationCtx *cx, uint32_t seq, int head)
+{
+    tick_t t0 = tk_now();
+    int nmark = 0;
+    size_t bytes = 0;
+    int rc = ckpt_save_state(cx, seq, t0, &nmark, &bytes);
+    double pause = tk_to_s((int64_t)(tk_now() - t0));
+
+    cx->ck_seq = seq;
+    cx->ck_n++;
+    cx->ck_pause_sum_s += pause;
+    if (pause > cx->ck_pause_max_s)
+        cx->ck_pause_max_s = pause;
+
+    if (rc == 0)
+    {
+        if (cx->idx == 2)
+            ckpt_commit(cx->ck, seq, head);
+        uint32_t committed;
+        if (ckpt_committed(cx->ck, &committed, NULL) == 0)
+            ckpt_prune(cx->ck, cx->idx, committed);
+    }
+    char role[24];
+    snprintf(role, sizeof(role), "station%d", cx->idx + 1);
+    LOG(role, "checkpoint #%u: %d en cola, %zu bytes, pausa=%.1fus%s",
+        seq, nmark, bytes, pause * 1e6, (rc == 0 && cx->idx == 2) ? " (confirmado)" : "");
+}
+
+/* Recarga cola, Gantt, agregados y estadísticas del snapshot 'seq'; rebasa
+   los ticks sobre el epoch nuevo que calculó el padre (ckpt_prepare_resume). */
+static int ckpt_restore(StationCtx *cx, uint32_t seq)
+{
+    tick_t t0 = tk_now();
+    CkptHeader h;
+    size_t len = 0;
+    char *buf = ckpt_load(cx->ck, cx->idx, seq, &h, &len);
+    if (!buf)
+        return -1;
+    size_t want = sizeof(Product) * (size_t)h.nq + sizeof(Slice) * (size_t)h.nslices +
+                  (sizeof(Rec) + sizeof(int) + sizeof(double)) * (size_t)h.nrecs;
+    if (len != want)
+    {
+        fprintf(stderr, "station%d: snapshot #%u de %zu bytes, se esperaban %zu\n",
+                cx->idx + 1, h.seq, len, want);
+        free(buf);
+        return -1;
+    }
+    char *p = buf;
+
+    for (uint32_t i = 0; i < h.nq && i < QCAP; i++, p += sizeof(Product))
+    {
+        Product pr;
+        memcpy(&pr, p, sizeof(Product));
+        if (pr.epoch_tk)
+        {
+            for (int s = 0; s < NSTAGES; ++s)
+            {
+                pr.t_arr_tk[s] = ckpt_rebase(cx->ck, &h, pr.t_arr_tk[s]);
+                pr.t_in_tk[s] = ckpt_rebase(cx->ck, &h, pr.t_in_tk[s]);
+                pr.t_out_tk[s] = ckpt_rebase(cx->ck, &h, pr.t_out_tk[s]);
+            }
+            pr.epoch_tk = cx->ck->epoch_tk;
+        }
+        if (pr.t_arr_tk[cx->idx] != 0)
+            cx->st_n++; // ya estaba en la estación
+        q_push(cx->q, &pr);
+    }
+    g_nslices = (int)(h.nslices < MAX_SLICES ? h.nslices : MAX_SLICES);
+    memcpy(g_slices, p, sizeof(Slice) * (size_t)g_nslices);
+    p += sizeof(Slice) * h.nslices;
+    for (int i = 0; i < g_nslices; i++)
+    {
+        g_slices[i].t0 = ckpt_rescale(&h, g_slices[i].t0);
+        g_slices[i].t1 = ckpt_rescale(&h, g_slices[i].t1);
+    }
+    g_rec_len = (int)(h.nrecs < MAX_PRODS ? h.nrecs : MAX_PRODS);
+    memcpy(g_recs, p, sizeof(Rec) * (size_t)g_rec_len);
+    p += sizeof(Rec) * h.nrecs;
+    for (int i = 0; i < g_rec_len; i++)
+        for (int s = 0; s < 3; ++s)
+        {
+            g_recs[i].t_arr[s] = ckpt_rescale(&h, g_recs[i].t_arr[s]);
+            g_recs[i].t_in[s] = ckpt_rescale(&h, g_recs[i].t_in[s]);
+            g_recs[i].t_out[s] = ckpt_rescale(&h, g_recs[i].t_out[s]);
+        }
+    g_finish_len = g_rec_len; // E3 llena ambos a la par
+    memcpy(g_finish_order, p, sizeof(int) * (size_t)g_finish_len);
+    p += sizeof(int) * h.nrecs;
+    memcpy(g_finish_time, p, sizeof(double) * (size_t)g_finish_len);
+
+    g_sum_tat_total = h.sum_tat;
+    g_sum_wait_total = h.sum_wait;
+    g_n_done_total = h.n_done;
+    cx->max_id = h.next_id - 1;
+
+    // estadísticas: mismo rebase que los productos (tiempo caído no cuenta)
+    tick_t now = tk_now();
+    cx->st_area_tk = s_to_tk(h.st_area_s);
+    cx->st_busy_tk = s_to_tk(h.st_busy_s);
+    cx->st_done = h.st_done;
+    cx->st_first_tk = (h.st_first_s >= 0.0) ? cx->ck->epoch_tk + (tick_t)s_to_tk(h.st_first_s) : 0;
+    cx->st_end_tk = (h.st_end_s >= 0.0) ? cx->ck->epoch_tk + (tick_t)s_to_tk(h.st_end_s) : 0;
+    cx->st_last_tk = cx->st_first_tk ? now : 0;
+    free(buf);
+
+    char role[24];
+    snprintf(role, sizeof(role), "station%d", cx->idx + 1);
+    if (h.seq == CKPT_SEQ_FINAL)
+        LOG(role, "restaurado estado final (Gantt y estadísticas) en %.3f ms",
+            tk_to_s((int64_t)(tk_now() - t0)) * 1e3);
+    else
+        LOG(role, "restaurado snapshot #%u: %u en cola, %d terminados, en %.3f ms",
+            h.seq, h.nq, g_n_done_total, tk_to_s((int64_t)(tk_now() - t0)) * 1e3);
+    return 0;
+}
+
 /* ------------------ Worker (FCFS / RR) ------------------ */
 static void *th_worker(void *arg)
 {
@@ -243,40 +485,76 @@ static void *th_worker(void *arg)
         if (atomic_load(cx->done) && cx->q->size == 0)
             break;
 
+        // La cabeza viva (E1, o quien ya recibió FIN+EOF de arriba) inicia un
+        // checkpoint cada interval_ms, siempre entre slices
+        if (cx->ck->interval_ms > 0 &&
+            (cx->idx == 0 || (atomic_load(cx->done) && atomic_load(&cx->eos))) &&
+            tk_now() >= cx->ck_next_tk)
+        {
+            Product m;
+            ckpt_marker(&m, cx->ck_seq + 1, cx->idx);
+            ckpt_take(cx, cx->ck_seq + 1, cx->idx);
+            if (cx->idx < 2)
+                write_full(cx->out_fd, &m, sizeof(Product));
+            cx->ck_next_tk = tk_now() + (tick_t)s_to_tk(cx->ck->interval_ms / 1000.0);
+        }
+
         Product p;
-        q_pop(cx->q, &p); // FCFS a nivel de cola de llegada
+        if (!q_pop(cx->q, &p)) // FCFS a nivel de cola de llegada
+            continue;          // despertado por EOF con la cola vacía
+
+        // E2/E3: marcador de checkpoint → snapshot, reenviar y soltar al lector
+        if (ckpt_is_marker(&p))
+        {
+            ckpt_take(cx, ckpt_marker_seq(&p), ckpt_marker_head(&p));
+            if (cx->idx < 2)
+                write_full(cx->out_fd, &p, sizeof(Product));
+            sem_post(&cx->ck_ack);
+            continue;
+        }
+        if (p.id > cx->max_id)
+            cx->max_id = p.id;
 
         /* E1 fija el epoch y respeta arrival */
         if (cx->idx == 0)
         {
             if (!atomic_load(cx->epoch_set))
             {
-                double epoch = now_s();
+                tick_t epoch = tk_now();
                 *cx->epoch_value = epoch;
                 atomic_store(cx->epoch_set, 1);
-                LOG("station1", "epoch_s=%.6f fijado al entrar P#%02d", epoch, p.id);
+                LOG("station1", "epoch_s=%.6f fijado al entrar P#%02d", tk_mono_s(epoch), p.id);
             }
-            if (p.epoch_s == 0.0)
-                p.epoch_s = *cx->epoch_value;
+            if (p.epoch_tk == 0)
+                p.epoch_tk = *cx->epoch_value;
 
             // gate de llegada: no entrar antes de arrival_s
-            double elapsed = now_s() - p.epoch_s;
-            if (elapsed < p.arrival_s)
+            int64_t elapsed = (int64_t)(tk_now() - p.epoch_tk);
+            int64_t arrival = s_to_tk(p.arrival_s);
+            if (elapsed < arrival)
             {
-                int wait_ms = (int)((p.arrival_s - elapsed) * 1000.0 + 0.5);
+                int wait_ms = (int)(tk_to_s(arrival - elapsed) * 1000.0 + 0.5);
                 if (wait_ms > 0)
                     sleep_ms(wait_ms);
             }
+            // llegada efectiva a E1 (para el modelo): al pasar el gate
+            if (p.t_arr_tk[0] == 0)
+            {
+                p.t_arr_tk[0] = tk_now();
+                st_change(cx, +1);
+            }
         }
         else
         {
-            if (p.epoch_s == 0.0)
-                p.epoch_s = *cx->epoch_value;
+            if (p.epoch_tk == 0)
+                p.epoch_tk = *cx->epoch_value;
+            else if (*cx->epoch_value == 0)
+                *cx->epoch_value = p.epoch_tk; // para snapshots y estadísticas
         }
 
         // Marca de entrada solo la primera vez en esta estación
-        if (p.t_in_s[cx->idx] <= 0.0)
-            p.t_in_s[cx->idx] = now_s() - p.epoch_s;
+        if (p.t_in_tk[cx->idx] == 0)
+            p.t_in_tk[cx->idx] = tk_now();
 
         int *rem = &p.rem_ms[cx->idx];
 
@@ -286,12 +564,13 @@ static void *th_worker(void *arg)
             int work = *rem > 0 ? *rem : 0;
             if (work > 0)
             {
-                double s0 = now_s() - p.epoch_s;
+                tick_t s0 = tk_now();
                 sleep_ms(work);
-                double s1 = now_s() - p.epoch_s;
-                gantt_add(p.id, s0, s1);
+                tick_t s1 = tk_now();
+                gantt_add(p.id, (int64_t)(s0 - p.epoch_tk), (int64_t)(s1 - p.epoch_tk));
+                cx->st_busy_tk += (int64_t)(s1 - s0);
                 // marcar salida también
-                p.t_out_s[cx->idx] = s1;
+                p.t_out_tk[cx->idx] = s1;
             }
             *rem = 0;
         }
@@ -304,19 +583,20 @@ static void *th_worker(void *arg)
             const int slice = (*rem > q) ? q : *rem;
             if (slice > 0)
             {
-                const double s0 = now_s() - p.epoch_s; // inicio del slice
-                sleep_ms(slice);                       // simula ejecución por 'slice'
-                const double s1 = now_s() - p.epoch_s; // fin del slice
-                gantt_add(p.id, s0, s1);               // registrar slice en Gantt
+                const tick_t s0 = tk_now(); // inicio del slice
+                sleep_ms(slice);            // simula ejecución por 'slice'
+                const tick_t s1 = tk_now(); // fin del slice
+                gantt_add(p.id, (int64_t)(s0 - p.epoch_tk), (int64_t)(s1 - p.epoch_tk));
+                cx->st_busy_tk += (int64_t)(s1 - s0);
                 *rem -= slice;
             }
             // NO marcar salida aquí; lo haremos justo después si rem == 0
         }
 
         // Marcar salida (común a FCFS y RR) solo si ya no queda remanente
-        if (*rem <= 0 && p.t_out_s[cx->idx] <= 0.0)
+        if (*rem <= 0 && p.t_out_tk[cx->idx] == 0)
         {
-            p.t_out_s[cx->idx] = now_s() - p.epoch_s;
+            p.t_out_tk[cx->idx] = tk_now();
         }
 
         if (cx->idx < 2)
@@ -330,10 +610,11 @@ static void *th_worker(void *arg)
             else
             {
                 // Completó esta estación → pasa a la siguiente
+                st_change(cx, -1);
                 write_full(cx->out_fd, &p, sizeof(Product));
                 LOG((cx->idx == 0) ? "station1" : "station2",
                     "P#%02d E%d done [%.3f→%.3f] → next",
-                    p.id, cx->idx + 1, p.t_in_s[cx->idx], p.t_out_s[cx->idx]);
+                    p.id, cx->idx + 1, rel_s(&p, p.t_in_tk[cx->idx]), rel_s(&p, p.t_out_tk[cx->idx]));
             }
         }
         else
@@ -347,20 +628,22 @@ static void *th_worker(void *arg)
             else
             {
                 // Terminó E3 → guardar para resumen y mostrar métricas
+                st_change(cx, -1);
                 if (g_rec_len < MAX_PRODS)
                 {
                     g_recs[g_rec_len].id = p.id;
                     g_recs[g_rec_len].arrival = p.arrival_s;
                     for (int s = 0; s < 3; ++s)
                     {
-                        g_recs[g_rec_len].t_in[s] = p.t_in_s[s];
-                        g_recs[g_rec_len].t_out[s] = p.t_out_s[s];
+                        g_recs[g_rec_len].t_arr[s] = (int64_t)(p.t_arr_tk[s] - p.epoch_tk);
+                        g_recs[g_rec_len].t_in[s] = (int64_t)(p.t_in_tk[s] - p.epoch_tk);
+                        g_recs[g_rec_len].t_out[s] = (int64_t)(p.t_out_tk[s] - p.epoch_tk);
                         g_recs[g_rec_len].svc_ms[s] = p.svc_ms[s];
                     }
                     g_rec_len++;
                 }
 
-                double tat_total = p.t_out_s[2] - p.arrival_s;
+                double tat_total = rel_s(&p, p.t_out_tk[2]) - p.arrival_s;
                 double wt_total = tat_total - total_burst_s(&p);
                 if (wt_total < 0)
                     wt_total = 0.0;
@@ -372,12 +655,12 @@ static void *th_worker(void *arg)
                 if (g_finish_len < MAX_PRODS)
                 {
                     g_finish_order[g_finish_len] = p.id;
-                    g_finish_time[g_finish_len] = p.t_out_s[2];
+                    g_finish_time[g_finish_len] = rel_s(&p, p.t_out_tk[2]);
                     g_finish_len++;
                 }
 
                 LOG("station3", "P#%02d E3 done [%.3f→%.3f] → fin",
-                    p.id, p.t_in_s[2], p.t_out_s[2]);
+                    p.id, rel_s(&p, p.t_in_tk[2]), rel_s(&p, p.t_out_tk[2]));
                 print_metrics(&p);
             }
         }
@@ -385,9 +668,48 @@ static void *th_worker(void *arg)
     return NULL;
 }
 
+/* ------------------ Modelo analítico (solo en E3) ------------------ */
+
+static void st_fill(const StationCtx *cx, StationStats *st)
+{
+    *st = (StationStats){.idx = cx->idx, .cfg = cx->cfg, .n_done = cx->st_done};
+    if (cx->st_first_tk && cx->st_end_tk > cx->st_first_tk)
+        st->span_s = tk_to_s((int64_t)(cx->st_end_tk - cx->st_first_tk));
+    st->area_s = tk_to_s(cx->st_area_tk);
+    st->busy_s = tk_to_s(cx->st_busy_tk);
+}
+
+/* Convierte los registros de E3 a segundos y junta las estadísticas que
+   E1/E2 dejaron en /tmp antes de cerrar su pipe de salida. */
+static void print_model_report(const StationCtx *cx, const ModelConfig *mc)
+{
+    static ModelRec mr[MAX_PRODS];
+    for (int k = 0; k < g_rec_len; k++)
+    {
+        mr[k] = (ModelRec){.id = g_recs[k].id, .arrival = g_recs[k].arrival};
+        for (int s = 0; s < NSTAGES; ++s)
+        {
+            mr[k].t_arr[s] = tk_to_s(g_recs[k].t_arr[s]);
+            mr[k].t_in[s] = tk_to_s(g_recs[k].t_in[s]);
+            mr[k].t_out[s] = tk_to_s(g_recs[k].t_out[s]);
+            mr[k].svc_s[s] = g_recs[k].svc_ms[s] / 1000.0;
+        }
+    }
+    StationStats st[NSTAGES];
+    for (int s = 0; s < NSTAGES; ++s)
+    {
+        if (s == cx->idx)
+            st_fill(cx, &st[s]);
+        else if (stats_load(s, &st[s]) < 0)
+            st[s] = (StationStats){.idx = s, .cfg = mc->cfg[s]};
+    }
+    model_report(mr, g_rec_len, st, mc);
+}
+
 /* Arranque estándar de estación con cola (lector + worker) */
 static void run_station_with_queue(int in_fd, int out_fd, int idx, StationConfig cfg,
-                                   atomic_int *epoch_set, double *epoch_value)
+                                   const CkptConfig *ck, const ModelConfig *mc,
+                                   atomic_int *epoch_set, tick_t *epoch_value)
 {
     char role[16];
     snprintf(role, sizeof(role), "station%d", idx + 1);
@@ -399,7 +721,32 @@ static void run_station_with_queue(int in_fd, int out_fd, int idx, StationConfig
     atomic_int done = 0;
 
     StationCtx cx = {
-        .in_fd = in_fd, .out_fd = out_fd, .idx = idx, .cfg = cfg, .q = &q, .done = &done, .epoch_set = epoch_set, .epoch_value = epoch_value};
+        .in_fd = in_fd, .out_fd = out_fd, .idx = idx, .cfg = cfg, .q = &q, .done = &done, .epoch_set = epoch_set, .epoch_value = epoch_value, .ck = ck};
+    sem_init(&cx.ck_ack, 0, 0);
+    pthread_mutex_init(&cx.st_mtx, NULL);
+    cx.ck_next_tk = tk_now() + (tick_t)s_to_tk(ck->interval_ms / 1000.0);
+
+    // Reanudar: cola, Gantt y agregados desde el snapshot confirmado
+    // (las estaciones antes de la cabeza ya habían terminado: solo recargan
+    // su estado final para el Gantt y el modelo)
+    if (ck->resume && idx >= ck->head)
+    {
+        if (ckpt_restore(&cx, ck->seq) < 0)
+        {
+            LOG(role, "no se pudo restaurar el snapshot #%u", ck->seq);
+            exit(1);
+        }
+    }
+    else if (ck->resume && ckpt_restore(&cx, CKPT_SEQ_FINAL) < 0)
+    {
+        LOG(role, "sin snapshot final; Gantt y estadísticas arrancan vacíos");
+    }
+    if (ck->resume && ck->epoch_tk)
+    {
+        *epoch_value = ck->epoch_tk;
+        atomic_store(epoch_set, 1);
+    }
+    cx.ck_seq = ck->resume ? ck->seq : 0;
 
     pthread_t tr, tw;
     pthread_create(&tr, NULL, th_reader, &cx);
@@ -414,6 +761,19 @@ static void run_station_with_queue(int in_fd, int out_fd, int idx, StationConfig
     // Guardar SOLO IDs por slice (con repeticiones) para esta estación
     save_ids_sequence_to_tmp(idx);
 
+    // Estadísticas para el modelo (E3 las lee de /tmp, como los .ids)
+    StationStats st;
+    st_fill(&cx, &st);
+    stats_save(&st);
+
+    // Terminó bien: snapshot final (cola vacía) por si se reanuda más abajo
+    if (ck->interval_ms > 0 && atomic_load(&cx.eos) && idx < 2)
+    {
+        int nq;
+        size_t bytes;
+        ckpt_save_state(&cx, CKPT_SEQ_FINAL, tk_now(), &nq, &bytes);
+    }
+
     // Resumen final (solo en E3)
     if (idx == 2)
     {
@@ -434,11 +794,25 @@ static void run_station_with_queue(int in_fd, int out_fd, int idx, StationConfig
             printf("No se completaron productos en E3.\n");
         }
         printf("=========================\n");
+
+        print_model_report(&cx, mc);
     }
 
+    if (cx.ck_n > 0)
+        LOG(role, "checkpoints: %d, pausa media=%.1fus max=%.1fus",
+            cx.ck_n, cx.ck_pause_sum_s / cx.ck_n * 1e6, cx.ck_pause_max_s * 1e6);
+
+    pthread_mutex_destroy(&cx.st_mtx);
+    sem_destroy(&cx.ck_ack);
     q_destroy(&q);
     if (in_fd >= 0)
         close(in_fd);
+    if (out_fd >= 0 && idx < 2 && atomic_load(&cx.eos))
+    {
+        Product fin; // solo si terminamos bien: abajo puede pasar a ser cabeza
+        ckpt_eos(&fin);
+        write_full(out_fd, &fin, sizeof(Product));
+    }
     if (out_fd >= 0 && idx < 2)
         close(out_fd); // E3 no tiene siguiente
     LOG(role, "fin");
@@ -446,21 +820,22 @@ static void run_station_with_queue(int in_fd, int out_fd, int idx, StationConfig
 }
 
 /* Wrappers por estación */
-void station1_with_queue(int in_fd, int out_fd, StationConfig cfg)
+void station1_with_queue(int in_fd, int out_fd, StationConfig cfg, const CkptConfig *ck)
 {
     static atomic_int epoch_set = 0;
-    static double epoch_value = 0.0;
-    run_station_with_queue(in_fd, out_fd, 0, cfg, &epoch_set, &epoch_value);
+    static tick_t epoch_value = 0;
+    run_station_with_queue(in_fd, out_fd, 0, cfg, ck, NULL, &epoch_set, &epoch_value);
 }
-void station2_with_queue(int in_fd, int out_fd, StationConfig cfg)
+void station2_with_queue(int in_fd, int out_fd, StationConfig cfg, const CkptConfig *ck)
 {
     static atomic_int epoch_set = 1; // ya fijado por E1
-    static double epoch_value = 0.0;
-    run_station_with_queue(in_fd, out_fd, 1, cfg, &epoch_set, &epoch_value);
+    static tick_t epoch_value = 0;
+    run_station_with_queue(in_fd, out_fd, 1, cfg, ck, NULL, &epoch_set, &epoch_value);
 }
-void station3_with_queue_and_metrics(int in_fd, StationConfig cfg)
+void station3_with_queue_and_metrics(int in_fd, StationConfig cfg, const CkptConfig *ck,
+                                     const ModelConfig *mc)
 {
     static atomic_int epoch_set = 1;
-    static double epoch_value = 0.0;
-    run_station_with_queue(in_fd, -1, 2, cfg, &epoch_set, &epoch_value);
+    static tick_t epoch_value = 0;
+    run_station_with_queue(in_fd, -1, 2, cfg, ck, mc, &epoch_set, &epoch_value);
 }
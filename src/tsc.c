@@ -0,0 +1,148 @@
+#include <float.h>
+#include <stdio.h>
+#include "ipc.h"
+#include "tsc.h"
+
+#if defined(TSC_HAVE_RDTSC)
+#include <cpuid.h>
+#endif
+
+/* Antes de calibrar: respaldo en ns de CLOCK_MONOTONIC (LOG ya funciona) */
+TscClock g_tsc = { .use_tsc = 0, .hz = 1e9, .s_per_tick = 1e-9, .tk0 = 0, .mono0_s = 0.0 };
+
+#define CAL_WINDOW_MS 500 // error de un par (~100 ns) / ventana => < 1 ppm
+#define CAL_PAIRS 16      // pares por extremo; se usa el de menor rdtsc b-a
+#define CAL_WARMUP 64     // llamadas en frío (vDSO, caché, frecuencia)
+#define BENCH_DRIFT_MS 3000
+
+/* CPUID.80000007H:EDX[8] => TSC invariante (ritmo constante, no se detiene en C-states) */
+static int has_invariant_tsc(void)
+{
+#if defined(TSC_HAVE_RDTSC)
+    unsigned a, b, c, d;
+    if (!__get_cpuid(0x80000000u, &a, &b, &c, &d) || a < 0x80000007u)
+        return 0;
+    __get_cpuid(0x80000007u, &a, &b, &c, &d);
+    return (d >> 8) & 1u;
+#else
+    return 0;
+#endif
+}
+
+#if defined(TSC_HAVE_RDTSC)
+/* Par (tsc, monotonic) tomado lo más junto posible: rdtsc antes y después
+   de clock_gettime, punto medio. De CAL_PAIRS intentos se queda con el de
+   menor b-a (el que no sufrió interrupción ni fallo de caché). */
+static void tsc_mono_pair(tick_t *tk, double *mono)
+{
+    tick_t best = (tick_t)-1;
+    for (int i = 0; i < CAL_PAIRS; i++)
+    {
+        tick_t a = (tick_t)__rdtsc();
+        double m = now_s();
+        tick_t b = (tick_t)__rdtsc();
+        if (b - a < best)
+        {
+            best = b - a;
+            *tk = a + (b - a) / 2;
+            *mono = m;
+        }
+    }
+}
+#endif
+
+void tsc_calibrate(void)
+{
+#if defined(TSC_HAVE_RDTSC)
+    if (has_invariant_tsc())
+    {
+        tick_t t0 = 0, t1 = 0;
+        double m0 = 0.0, m1 = 0.0;
+        volatile double sink = 0.0;
+        for (int i = 0; i < CAL_WARMUP; i++) // el primer par no debe ir en frío
+            sink += now_s() + (double)__rdtsc();
+        (void)sink;
+        tsc_mono_pair(&t0, &m0);
+        sleep_ms(CAL_WINDOW_MS);
+        tsc_mono_pair(&t1, &m1);
+        if (m1 > m0 && t1 > t0)
+        {
+            g_tsc.use_tsc = 1;
+            g_tsc.hz = (double)(t1 - t0) / (m1 - m0);
+            g_tsc.s_per_tick = 1.0 / g_tsc.hz;
+            g_tsc.tk0 = t1;
+            g_tsc.mono0_s = m1;
+            LOG("tsc", "TSC invariante calibrado: %.3f MHz", g_tsc.hz / 1e6);
+            return;
+        }
+    }
+#endif
+    g_tsc.use_tsc = 0;
+    g_tsc.hz = 1e9;
+    g_tsc.s_per_tick = 1e-9;
+    g_tsc.tk0 = 0;
+    g_tsc.mono0_s = 0.0;
+    LOG("tsc", "sin TSC invariante; ticks = ns de CLOCK_MONOTONIC");
+}
+
+/* ------------------ Microbenchmark tk_now() vs now_s() ------------------ */
+
+void tsc_bench(int iters)
+{
+    volatile double sink_d = 0.0;
+    volatile tick_t sink_t = 0;
+
+    // costo por llamada
+    double a = now_s();
+    for (int i = 0; i < iters; i++)
+        sink_d += now_s();
+    double b = now_s();
+    for (int i = 0; i < iters; i++)
+        sink_t += tk_now();
+    double c = now_s();
+    double ns_now_s = (b - a) * 1e9 / iters;
+    double ns_tk_now = (c - b) * 1e9 / iters;
+
+    // resolución: menor salto positivo entre dos lecturas consecutivas
+    double res_now_s = DBL_MAX, res_tk_now = DBL_MAX;
+    double prev_d = now_s();
+    for (int i = 0; i < iters; i++)
+    {
+        double x = now_s();
+        if (x > prev_d && x - prev_d < res_now_s)
+            res_now_s = x - prev_d;
+        prev_d = x;
+    }
+    tick_t prev_t = tk_now();
+    for (int i = 0; i < iters; i++)
+    {
+        tick_t x = tk_now();
+        if (x > prev_t && tk_to_s((int64_t)(x - prev_t)) < res_tk_now)
+            res_tk_now = tk_to_s((int64_t)(x - prev_t));
+        prev_t = x;
+    }
+
+    // desvío de la calibración frente al reloj de referencia: un error de hz
+    // solo se nota tras un intervalo real, no justo después de calibrar
+    double off0 = tk_mono_s(tk_now()) - now_s();
+    double m0 = now_s();
+    sleep_ms(BENCH_DRIFT_MS);
+    double off1 = tk_mono_s(tk_now()) - now_s();
+    double drift = off1 - off0;
+    double ppm = drift / (now_s() - m0) * 1e6;
+    double ulp = now_s() * DBL_EPSILON; // precisión del double de now_s() hoy
+
+    printf("\n===== BENCH reloj (%d llamadas) =====\n", iters);
+    printf("fuente tk_now():   %s (%.3f MHz)\n",
+           g_tsc.use_tsc ? "rdtsc" : "clock_gettime", g_tsc.hz / 1e6);
+    printf("now_s()  costo: %8.2f ns/llamada   resolución: %8.2f ns\n",
+           ns_now_s, res_now_s * 1e9);
+    printf("tk_now() costo: %8.2f ns/llamada   resolución: %8.2f ns\n",
+           ns_tk_now, res_tk_now * 1e9);
+    printf("ulp(double) de now_s() a %.0fs de uptime: %.3g ns\n", now_s(), ulp * 1e9);
+    printf("desvío tk_mono_s() - now_s(): %+.3f us al inicio, %+.3f us en %d ms (%+.2f ppm)\n",
+           off0 * 1e6, drift * 1e6, BENCH_DRIFT_MS, ppm);
+    printf("====================================\n");
+    (void)sink_d;
+    (void)sink_t;
+}